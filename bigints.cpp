@@ -1,12 +1,21 @@
 #include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include <new>
 //#include <bitset>
 //#include <cmath>
 #include <cassert>
 #include <climits>
 #include <tuple>
 #include <string>
+#include <vector>
+#include <random>
+#include <thread>
+#include <algorithm>
 
 #include "bigints.hpp"
+#include "storage.hpp"
 
 #define ABS_M(a) (a < 0 ? -a : a)
 
@@ -14,33 +23,86 @@
 
 namespace BigInts
 {
-    BigInt::BigInt(digit_t *list, len_t len) // Make a BigInt from a list
+    namespace
     {
-        m_len = len; // Set the length of the integer
-        m_digits = new digit_t[ABS_M(len)]; // Assign memory for the digits
+        struct DigitStream // digits walked through by streamBlocks; block i covers digits[offset + i]
+        {
+            const digit_t *digits;
+            len_t offset;
+            DigitStream(const digit_t *digits, len_t offset = 0) : digits{ digits }, offset{ offset } {}
+        };
+
+        // Calls f(begin, end) on consecutive blocks of [0, len), from the top block down if `down`,
+        // until f returns false. Mapped streams have the next block prefetched while f runs, and
+        // every finished block released, so huge numbers are walked through with bounded memory.
+        template <typename F>
+        void streamBlocks(len_t len, bool down, std::initializer_list<DigitStream> streams, F f)
+        {
+            for (len_t done{ 0 }; done < len; done += STREAM_BLOCK_G)
+            {
+                len_t begin = (down ? std::max<len_t>(0, len - done - STREAM_BLOCK_G) : done);
+                len_t end = std::min(len, begin + STREAM_BLOCK_G);
+                if (down) end = len - done;
 
-        for (len_t i{ 0 }; i < ABS_M(len); ++i) // for every number in the list
-            m_digits[i] = list[i]; // copy it over to the list of digits
+                for (const DigitStream& s : streams)
+                {
+                    if (down) prefetchDigits(s.digits, s.offset + std::max<len_t>(0, begin - STREAM_BLOCK_G), s.offset + begin);
+                    else prefetchDigits(s.digits, s.offset + end, s.offset + std::min(len, end + STREAM_BLOCK_G));
+                }
+                bool more = f(begin, end);
+                for (const DigitStream& s : streams) releaseDigits(s.digits, s.offset + begin, s.offset + end);
+                if (!more) return;
+            }
+        }
+    }
 
-        delete[] list;
+    BigInt::BigInt(digit_t *list, len_t len) // Make a BigInt from a list
+    {
+        m_len = len; // Set the length of the integer
+        m_digits = list; // take over the digits, which came from allocDigits
     }
     BigInt::BigInt() // 0
     { m_digits = nullptr; m_len = 0; }
     BigInt::BigInt(const BigInt& other) // copy another BigInt
     {
         m_len = other.m_len;
-        m_digits = new digit_t[ABS_M(m_len)];
+        m_digits = allocDigits(ABS_M(m_len));
 
-        for (len_t i{ 0 }; i < ABS_M(m_len); ++i)
-            m_digits[i] = other.m_digits[i];
+        streamBlocks(ABS_M(m_len), false, { other.m_digits, m_digits }, [&](len_t begin, len_t end)
+        {
+            std::copy(other.m_digits + begin, other.m_digits + end, m_digits + begin);
+            return true;
+        });
     }
     BigInt& BigInt::operator=(const BigInt& other) // copy asygnment
     {
-        delete[] m_digits;
+        if (this == &other) return *this;
+        digit_t *digits = allocDigits(ABS_M(other.m_len)); // copy first, so that if this throws *this is untouched
+
+        streamBlocks(ABS_M(other.m_len), false, { other.m_digits, digits }, [&](len_t begin, len_t end)
+        {
+            std::copy(other.m_digits + begin, other.m_digits + end, digits + begin);
+            return true;
+        });
+
+        freeDigits(m_digits);
+        m_digits = digits;
         m_len = other.m_len;
-        m_digits = new digit_t[ABS_M(m_len)];
-        for (len_t i{ 0 }; i < ABS_M(m_len); ++i)
-            m_digits[i] = other.m_digits[i];
+        return *this;
+    }
+    BigInt::BigInt(BigInt&& other) noexcept // take over the digits of another BigInt
+    {
+        m_len = other.m_len;
+        m_digits = other.m_digits;
+        other.m_digits = nullptr; other.m_len = 0; // leave it as 0
+    }
+    BigInt& BigInt::operator=(BigInt&& other) noexcept // move asygnment
+    {
+        if (this == &other) return *this;
+        freeDigits(m_digits);
+        m_len = other.m_len;
+        m_digits = other.m_digits;
+        other.m_digits = nullptr; other.m_len = 0; // leave it as 0
         return *this;
     }
     BigInt::BigInt(int64 i) // make a BigInt form an integer
@@ -49,7 +111,7 @@ namespace BigInts
         { m_digits = nullptr; m_len = 0; } // 0
         else if (-DIGIT_MAX_G < i && i < DIGIT_MAX_G) // The number has one "digit"
         {
-            m_digits = new digit_t[1]; // one digit
+            m_digits = allocDigits(1); // one digit
             m_len = (i < 0 ? -1 : 1); // a negative length means a negative number
             m_digits[0] = ABS_M(i); // assign the digit
         }
@@ -64,7 +126,7 @@ namespace BigInts
             { ++len; tmp >>= DIGIT_BITS_G; } // calculate the # of digits needed
 
             m_len = (neg ? -len : len); // a negative length means a negative number
-            m_digits = new digit_t[len]; // allocate memory for the digits
+            m_digits = allocDigits(len); // allocate memory for the digits
 
             for (len_t j{ 0 }; j < len; ++j) // assign the digits
             {
@@ -77,7 +139,23 @@ namespace BigInts
     }
     BigInt::~BigInt()
     {
-        if (m_digits != nullptr) delete[] m_digits; // de-allocate memory
+        if (m_digits != nullptr) freeDigits(m_digits); // de-allocate memory
+    }
+
+    BigInt BigInt::fromLimbs(std::vector<digit_t> limbs, bool neg) // Make a BigInt from its digits
+    {
+        len_t len = limbs.size();
+        while (len != 0 && limbs[len-1] == 0) --len; // avoid leading zeroes
+        if (len == 0) return {};
+
+        digit_t *tmp = allocDigits(len);
+        for (len_t i{ 0 }; i < len; ++i) tmp[i] = limbs[i];
+
+        return { tmp, (neg ? -len : len) };
+    }
+    std::vector<digit_t> BigInt::limbs() const // the digits of abs(*this), least significant first
+    {
+        return std::vector<digit_t>(m_digits, m_digits + ABS_M(m_len));
     }
 
     int64 BigInt::toInt64() const
@@ -113,130 +191,443 @@ namespace BigInts
         return *this; // return this
     }
 
-    std::string BigInt::toStr() const
+    namespace // helpers for writing BigInts as text and reading them back
     {
-        BigInt i{ *this };
-        std::string s = "";
+        constexpr size_t IO_CHUNK_G = 4096; // the amount of characters written at a time
 
-        if (!i.toBool()) s = "0"; // if i == 0
-        if (i < 0)
+        int log2Base(int base) // k if base == 2^k for some k in 1-5, 0 otherwise
         {
-            s = "-";
-            i = -i;
+            for (int k{ 1 }; k <= 5; ++k) if (base == 1 << k) return k;
+            return 0;
         }
-        while (i > 0)
+        int bitsPerChar(int base) // the most bits one character in base can hold
         {
-            s.insert(0, 1, '0' + (char)((i % 10).toInt64()));
-            i = i/10;
+            int k{ 0 };
+            while ((1 << k) < base) ++k;
+            return k;
         }
-
-        return s;
-    }
-
-    std::ostream& operator<<(std::ostream& out, const BigInt& i)
-    {
-        //for (int j{ 0 }; j < ABS_M(i.m_len); ++j) out << i.m_digits[j] << ' ';
-        //out << '{' << i.m_len << '}';
-        /*if (!i.toBool()) out << '0'; // if i == 0
-        if (i < 0)
+        int digitValue(int c) // the value of a digit character in a base up to 36, or 36 if it isn't one
         {
-            out << '-';
-            i = -i;
+            if ('0' <= c && c <= '9') return c - '0';
+            if ('a' <= c && c <= 'z') return c - 'a' + 10;
+            if ('A' <= c && c <= 'Z') return c - 'A' + 10;
+            return 36;
         }
-        while (i > 0)
+        int64 chunkPower(int base, int& digits) // the largest power of base below DIGIT_MAX_G, and its exponent
         {
-            out << (i % 10).toInt64();
-            i = i/10;
-        }*/
-        out << i.toStr();
-        return out;
-    }
-
-    BigInt operator+(const BigInt& a, const BigInt& b)
-    {
-        if (a.m_len < b.m_len) return b + a; // If a is garenteed to be > b, it simplifies the logic
-        if (a == -b) return 0; // x-x = 0
-        if (a.m_len == 0) return b; if (b.m_len == 0) return a; // x + 0 = x
+            int64 p{ 1 };
+            for (digits = 0; p*base < DIGIT_MAX_G; ++digits) p *= base;
+            return p;
+        }
+        // to[toAt, toAt+len) = from[fromAt, fromAt+len); both pointers are straight from allocDigits
+        void copyDigits(const digit_t *from, len_t fromAt, digit_t *to, len_t toAt, len_t len)
+        {
+            streamBlocks(len, false, { { from, fromAt }, { to, toAt } }, [&](len_t begin, len_t end)
+            {
+                std::copy(from + fromAt + begin, from + fromAt + end, to + toAt + begin);
+                return true;
+            });
+        }
 
-        len_t ma = std::max(ABS_M(a.m_len), ABS_M(b.m_len));
-        len_t mi = std::min(ABS_M(a.m_len), ABS_M(b.m_len));
+        digit_t divSmall(digit_t *n, len_t& len, int64 m) // n[0, len) /= m in place, returning the remainder; m < DIGIT_MAX_G
+        {
+            uint64 r{ 0 };
+            streamBlocks(len, true, { n }, [&](len_t begin, len_t end)
+            {
+                for (len_t i{ end }; i-- > begin;)
+                {
+                    r = (r << DIGIT_BITS_G) | (uint64)n[i];
+                    n[i] = (digit_t)(r / m);
+                    r %= m;
+                }
+                return true;
+            });
+            while (len != 0 && n[len-1] == 0) --len; // avoid leading zeroes
+            return (digit_t)r;
+        }
+        digit_t mulAddSmall(digit_t *n, len_t len, int64 m, uint64 a) // n[0, len) = n*m + a in place, returning the digit carried out
+        {
+            streamBlocks(len, false, { n }, [&](len_t begin, len_t end)
+            {
+                for (len_t i{ begin }; i < end; ++i)
+                {
+                    a += (uint64)n[i]*m;
+                    n[i] = a & DIGIT_MASK_G;
+                    a >>= DIGIT_BITS_G;
+                }
+                return true;
+            });
+            return (digit_t)a;
+        }
 
-        if (a.m_len < 0)
-        return -(-a + -b); // -x + -y = -(x + y)
-        else if (b.m_len > 0) // if both numbers are positive
+        // Passes the digits of the number in digits[0, len) in base to sink(chars, count), most
+        // significant first, IO_CHUNK_G characters at a time. Powers of two slice the bits straight
+        // out of the digits in linear time. Other bases take quadratic time: they divide a copy of
+        // the number by the largest power of base that fits in a digit, over and over, and keep the
+        // remainders; both come from allocDigits, so they are mapped like any other huge number.
+        template <typename Sink>
+        void writeDigits(const digit_t *digits, len_t len, int base, bool upper, Sink sink)
         {
-            len_t len = ma+1; // 9 + 9 = 18, but no x-digit numbers added together
-            // produces an x+2-digit number
-            digit_t *tmp = new digit_t[len]; // allocate memory for the new integer
-            for (len_t i{ 0 }; i < len; ++i) tmp[i] = 0; // NB: clear the memory
+            const char *chars = (upper ? "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ" : "0123456789abcdefghijklmnopqrstuvwxyz");
+            char buf[IO_CHUNK_G];
+            size_t used{ 0 };
+            auto put = [&](char c)
+            {
+                buf[used++] = c;
+                if (used == IO_CHUNK_G) { sink(buf, used); used = 0; }
+            };
 
-            len_t i{ 0 };
-            for (; i < mi; ++i) // for every digit in both numbers
+            if (len == 0) put('0');
+            else if (int k = log2Base(base))
             {
-                tmp[i] += a.m_digits[i] + b.m_digits[i]; // add the sum of the digits to tmp
-                if (tmp[i] >= DIGIT_MAX_G) // if the result is larger than the largest possible digit
+                int64 bits = (len-1)*DIGIT_BITS_G;
+                for (digit_t top{ digits[len-1] }; top != 0; top >>= 1) ++bits;
+
+                int64 i = (bits + k-1) / k; // the amount of characters left to write
+                streamBlocks(len, true, { digits }, [&](len_t begin, len_t)
                 {
-                    tmp[i] %= DIGIT_MAX_G; // make it small enough to fit
-                    tmp[i+1] = 1; // & overflow
-                }
+                    for (; i > 0 && (i-1)*k >= begin*DIGIT_BITS_G; --i) // every character starting in this block
+                    {
+                        int64 pos = (i-1)*k;
+                        len_t at = pos / DIGIT_BITS_G;
+                        int shift = pos % DIGIT_BITS_G;
+                        uint64 v = (uint64)digits[at] >> shift;
+                        if (shift + k > DIGIT_BITS_G && at+1 < len) v |= (uint64)digits[at+1] << (DIGIT_BITS_G - shift);
+                        put(chars[v & (base-1)]);
+                    }
+                    return true;
+                });
             }
-            for (; i < ma; ++i) // for the rest of the digits of the larger number
+            else
             {
-                digit_t *digits = (ABS_M(a.m_len) > ABS_M(b.m_len) ? a.m_digits : b.m_digits);
-                tmp[i] += digits[i]; // add the digit to tmp
-                if (tmp[i] >= DIGIT_MAX_G) // if the result is larger than the largest possible digit
+                int per{ 0 };
+                int64 p = chunkPower(base, per); // > 2^24, since base <= 36
+
+                len_t n_len = len;
+                digit_t *n = allocDigits(len);
+                copyDigits(digits, 0, n, 0, len);
+
+                digit_t *chunks = allocDigits(len*DIGIT_BITS_G/24 + 1); // chunks of `per` characters, least significant first
+                len_t count{ 0 };
+                while (n_len != 0)
                 {
-                    tmp[i] %= DIGIT_MAX_G; // make it small enough to fit
-                    tmp[i+1] = 1; // & overflow
+                    chunks[count++] = divSmall(n, n_len, p);
+                    if (count % STREAM_BLOCK_G == 0) releaseDigits(chunks, count - STREAM_BLOCK_G, count);
                 }
-            }
+                freeDigits(n);
 
-            while (len != 0 && tmp[ABS_M(len)-1] == 0) // avoid leading zeroes
-            {
-                if (len > 0) --len;
-                if (len < 0) ++len;
+                streamBlocks(count, true, { chunks }, [&](len_t begin, len_t end)
+                {
+                    for (len_t j{ end }; j-- > begin;)
+                    {
+                        char tmp[DIGIT_BITS_G];
+                        int c{ 0 };
+                        for (digit_t v{ chunks[j] }; c < per && (v != 0 || j+1 != count); v /= base)
+                        tmp[c++] = chars[v % base]; // the top chunk has no leading zeroes
+                        while (c > 0) put(tmp[--c]);
+                    }
+                    return true;
+                });
+                freeDigits(chunks);
             }
 
-            return { tmp, len }; // return the integer
+            if (used != 0) sink(buf, used);
         }
-        else if (a > -b) // abs(a) > abs(b); result > 0
+
+        // Builds up a number from its characters in base, most significant first, straight into
+        // allocDigits storage. Powers of two fill whole digits from the top of the buffer down, and
+        // finish() shifts them into place in one pass; other bases multiply-add into the buffer.
+        // Without a hint of the amount of characters, the buffer doubles whenever it runs out.
+        class DigitReader
         {
-            len_t len = ma;
-            digit_t *tmp = new digit_t[len];
-            for (len_t i{ 0 }; i < len; ++i) tmp[i] = 0;
+            int m_base;
+            int m_k; // log2Base(m_base)
+            digit_t *m_digits{ nullptr };
+            len_t m_cap{ 0 };
+            len_t m_len{ 0 }; // powers of two: digits in m_digits[m_cap-m_len, m_cap); otherwise in m_digits[0, m_len)
+            uint64 m_acc{ 0 }; // the bits / value not in m_digits yet
+            int m_accBits{ 0 };
+            int64 m_accPower{ 1 }; // base^(the amount of characters in m_acc)
+            bool m_any{ false };
 
-            len_t i{ 0 };
-            for (; i < mi; ++i)
+            void grow(len_t cap)
+            {
+                digit_t *d = allocDigits(cap);
+                if (m_k != 0) copyDigits(m_digits, m_cap - m_len, d, cap - m_len, m_len); // keep them at the top
+                else copyDigits(m_digits, 0, d, 0, m_len);
+                freeDigits(m_digits);
+                m_digits = d;
+                m_cap = cap;
+            }
+            void flush() // multiply-add m_acc into m_digits
             {
-                tmp[i] += a.m_digits[i] - b.m_digits[i];
-                if (tmp[i] < 0)
+                digit_t carry = mulAddSmall(m_digits, m_len, m_accPower, m_acc);
+                if (carry != 0)
                 {
-                    tmp[i] += DIGIT_MAX_G;
-                    tmp[i+1] = -1;
+                    if (m_len == m_cap) grow(std::max<len_t>(2*m_cap, 16));
+                    m_digits[m_len++] = carry;
                 }
+                m_acc = 0;
+                m_accPower = 1;
+            }
+
+        public:
+            explicit DigitReader(int base, len_t chars = 0) : m_base{ base }, m_k{ log2Base(base) }
+            {
+                if (chars != 0) grow((chars*bitsPerChar(base) + DIGIT_BITS_G-1) / DIGIT_BITS_G + 2);
+            }
+            DigitReader(const DigitReader&) = delete;
+            DigitReader& operator=(const DigitReader&) = delete;
+            ~DigitReader()
+            {
+                freeDigits(m_digits);
             }
-            for (; i < ma; ++i)
+
+            bool any() const { return m_any; }
+            bool push(int c) // takes in c if it is a digit in m_base, and returns whether it was
             {
-                tmp[i] += a.m_digits[i];
-                if (tmp[i] < 0)
+                int d = digitValue(c);
+                if (d >= m_base) return false;
+                m_any = true;
+
+                if (m_k != 0) // linear time: just append the bits
+                {
+                    m_acc = (m_acc << m_k) | d;
+                    m_accBits += m_k;
+                    if (m_accBits >= DIGIT_BITS_G)
+                    {
+                        m_accBits -= DIGIT_BITS_G;
+                        if (m_cap - m_len < 2) grow(std::max<len_t>(2*m_cap, 16)); // finish() needs the bottom slot
+                        ++m_len;
+                        m_digits[m_cap - m_len] = (digit_t)(m_acc >> m_accBits);
+                        m_acc &= ((uint64)1 << m_accBits) - 1;
+                        if (m_len % STREAM_BLOCK_G == 0) releaseDigits(m_digits, m_cap - m_len, m_cap - m_len + STREAM_BLOCK_G);
+                    }
+                }
+                else
                 {
-                    tmp[i] += DIGIT_MAX_G;
-                    tmp[i+1] = -1;
+                    m_acc = m_acc*m_base + d;
+                    m_accPower *= m_base;
+                    if (m_accPower*m_base >= DIGIT_MAX_G) flush();
                 }
+                return true;
             }
-
-            while (len != 0 && tmp[ABS_M(len)-1] == 0) // avoid leading zeroes
+            digit_t* finish(len_t& len) // hands over the digits of the number read, and sets len to how many there are
             {
-                if (len > 0) --len;
-                if (len < 0) ++len;
+                if (m_k == 0) flush();
+                else
+                {
+                    // digit i = (word i << m_accBits | word i-1 >> (DIGIT_BITS_G - m_accBits)), counting from the
+                    // least significant word at m_cap-m_len >= 1; writing digit i only overwrites words already used
+                    if (m_cap - m_len < 1) grow(std::max<len_t>(2*m_cap, 16));
+                    len_t from = m_cap - m_len;
+                    uint64 below = m_acc; // the bits that go under the next digit
+                    streamBlocks(m_len + 1, false, { m_digits, { m_digits, from } }, [&](len_t begin, len_t end)
+                    {
+                        for (len_t i{ begin }; i < end; ++i)
+                        {
+                            uint64 w = (i < m_len ? m_digits[from + i] : 0);
+                            m_digits[i] = (digit_t)(((w << m_accBits) | below) & DIGIT_MASK_G);
+                            below = w >> (DIGIT_BITS_G - m_accBits);
+                        }
+                        return true;
+                    });
+                    ++m_len;
+                }
+
+                while (m_len != 0 && m_digits[m_len-1] == 0) --m_len; // avoid leading zeroes
+                digit_t *r = m_digits;
+                len = m_len;
+                if (len == 0) { freeDigits(r); r = nullptr; }
+                m_digits = nullptr;
+                m_cap = m_len = 0;
+                return r;
             }
+        };
+
+        int streamBase(const std::ios_base& s) // the base std::hex, std::oct and std::dec ask for
+        {
+            std::ios_base::fmtflags base = s.flags() & std::ios_base::basefield;
+            return (base == std::ios_base::hex ? 16 : (base == std::ios_base::oct ? 8 : 10));
+        }
+    }
+
+    std::string BigInt::toStr() const
+    {
+        return toString(10);
+    }
+    std::string BigInt::toString(int base, bool upper) const // the digits in base 2-36; linear time for powers of two
+    {
+        if (base < 2 || base > 36)
+            throw std::invalid_argument{ "BigInt::toString: base " + std::to_string(base) + " isn't in 2 to 36" };
 
-            return { tmp, len };
+        std::string s = (m_len < 0 ? "-" : "");
+        writeDigits(m_digits, ABS_M(m_len), base, upper, [&](const char *chars, size_t count) { s.append(chars, count); });
+        return s;
+    }
+    BigInt BigInt::fromString(const std::string& str, int base) // an optional sign, then digits in base 2-36
+    {
+        if (base < 2 || base > 36)
+            throw std::invalid_argument{ "BigInt::fromString: base " + std::to_string(base) + " isn't in 2 to 36" };
+
+        size_t i{ 0 };
+        bool neg{ false };
+        if (i < str.size() && (str[i] == '-' || str[i] == '+')) neg = (str[i++] == '-');
+        if (base == 16 && (str.compare(i, 2, "0x") == 0 || str.compare(i, 2, "0X") == 0)) i += 2;
+        if (i == str.size()) throw std::invalid_argument{ "BigInt::fromString: there are no digits to read" };
+
+        DigitReader r{ base, (len_t)(str.size() - i) }; // the length is known, so the digits never move
+        for (; i < str.size(); ++i)
+        if (!r.push(str[i]))
+            throw std::invalid_argument{ "BigInt::fromString: '" + std::string(1, str[i]) + "' at position "
+                                         + std::to_string(i) + " isn't a digit in base " + std::to_string(base) };
+
+        len_t len;
+        digit_t *digits = r.finish(len);
+        return { digits, (neg ? -len : len) };
+    }
+
+    std::ostream& operator<<(std::ostream& out, const BigInt& i)
+    {
+        int base = streamBase(out);
+        bool upper = (out.flags() & std::ios_base::uppercase) != 0;
+
+        std::string prefix = (i.m_len < 0 ? "-" : ((out.flags() & std::ios_base::showpos) ? "+" : ""));
+        if ((out.flags() & std::ios_base::showbase) && i.m_len != 0)
+        prefix += (base == 16 ? (upper ? "0X" : "0x") : (base == 8 ? "0" : ""));
+
+        if (out.width() != 0) // padding needs the whole length up front
+        {
+            std::string s = prefix;
+            writeDigits(i.m_digits, ABS_M(i.m_len), base, upper, [&](const char *chars, size_t count) { s.append(chars, count); });
+            return out << s;
+        }
+
+        std::ostream::sentry ok{ out };
+        if (!ok) return out;
+        out.write(prefix.data(), prefix.size());
+        writeDigits(i.m_digits, ABS_M(i.m_len), base, upper, [&](const char *chars, size_t count) { out.write(chars, count); });
+        return out;
+    }
+    std::istream& operator>>(std::istream& in, BigInt& i)
+    {
+        std::istream::sentry ok{ in }; // skips leading whitespace
+        if (!ok) return in;
+
+        using traits = std::istream::traits_type;
+        std::streambuf *buf = in.rdbuf();
+        int base = streamBase(in);
+        DigitReader r{ base };
+
+        traits::int_type c = buf->sgetc();
+        bool neg{ false };
+        if (c == '-' || c == '+')
+        {
+            neg = (c == '-');
+            c = buf->snextc();
         }
-        else // abs(a) < abs(b); result < 0
+        if (base == 16 && c == '0') // either a 0x prefix or just a 0
+        {
+            c = buf->snextc();
+            if (c == 'x' || c == 'X') c = buf->snextc();
+            else r.push('0');
+        }
+        while (!traits::eq_int_type(c, traits::eof()) && r.push(c)) c = buf->snextc(); // read straight from the buffer
+
+        std::ios_base::iostate state = std::ios_base::goodbit;
+        if (traits::eq_int_type(c, traits::eof())) state |= std::ios_base::eofbit;
+        if (r.any())
         {
-            return -(-a + -b); // a - b = -(b - a)
+            len_t len;
+            digit_t *digits = r.finish(len);
+            freeDigits(i.m_digits); // take the digits over rather than copying them
+            i.m_digits = digits;
+            i.m_len = (neg ? -len : len);
         }
+        else state |= std::ios_base::failbit;
+        in.setstate(state);
+        return in;
+    }
+
+    int BigInt::compareAbs(const BigInt& a, const BigInt& b) // -1, 0 or 1 as abs(a) <, == or > abs(b)
+    {
+        len_t len = ABS_M(a.m_len);
+        if (len != ABS_M(b.m_len)) return (len < ABS_M(b.m_len) ? -1 : 1); // comepare the lengths
+
+        int r{ 0 };
+        streamBlocks(len, true, { a.m_digits, b.m_digits }, [&](len_t begin, len_t end)
+        {
+            for (len_t i{ end-1 }; i >= begin && r == 0; --i) // compare the digits, most significant first
+            r = (a.m_digits[i] < b.m_digits[i] ? -1 : (a.m_digits[i] > b.m_digits[i] ? 1 : 0));
+            return r == 0;
+        });
+        return r;
+    }
+    BigInt BigInt::addAbs(const BigInt& a, const BigInt& b, bool neg) // abs(a) + abs(b), negated if neg
+    {
+        const BigInt& big = (ABS_M(a.m_len) >= ABS_M(b.m_len) ? a : b);
+        const BigInt& small = (ABS_M(a.m_len) >= ABS_M(b.m_len) ? b : a);
+        len_t ma = ABS_M(big.m_len);
+        len_t mi = ABS_M(small.m_len);
+
+        len_t len = ma+1; // 9 + 9 = 18, but no x-digit numbers added together
+        // produces an x+2-digit number
+        digit_t *tmp = allocDigits(len); // allocate memory for the new integer
+
+        digit_t carry{ 0 };
+        streamBlocks(ma, false, { big.m_digits, small.m_digits, tmp }, [&](len_t begin, len_t end)
+        {
+            for (len_t i{ begin }; i < end; ++i) // for every digit of the larger number
+            {
+                digit_t d = big.m_digits[i] + (i < mi ? small.m_digits[i] : 0) + carry; // < 2^31, so no overflow
+                carry = d >> DIGIT_BITS_G; // if the result is larger than the largest possible digit, overflow
+                tmp[i] = d & (DIGIT_MAX_G-1); // & make it small enough to fit
+            }
+            return true;
+        });
+        tmp[ma] = carry;
+        if (carry == 0) --len; // avoid leading zeroes
+
+        return { tmp, (neg ? -len : len) }; // return the integer
+    }
+    BigInt BigInt::subAbs(const BigInt& a, const BigInt& b, bool neg) // abs(a) - abs(b), negated if neg; abs(a) >= abs(b)
+    {
+        len_t ma = ABS_M(a.m_len);
+        len_t mi = ABS_M(b.m_len);
+
+        len_t len = ma;
+        digit_t *tmp = allocDigits(len);
+
+        digit_t borrow{ 0 };
+        streamBlocks(ma, false, { a.m_digits, b.m_digits, tmp }, [&](len_t begin, len_t end)
+        {
+            for (len_t i{ begin }; i < end; ++i)
+            {
+                digit_t d = a.m_digits[i] - (i < mi ? b.m_digits[i] : 0) - borrow;
+                borrow = (d < 0);
+                tmp[i] = (borrow ? d + (digit_t)DIGIT_MAX_G : d);
+            }
+            return true;
+        });
+        assert (borrow == 0 && "abs(a) should be at least abs(b)!");
+
+        while (len != 0 && tmp[len-1] == 0) --len; // avoid leading zeroes
+        if (len == 0) { freeDigits(tmp); return {}; }
+
+        return { tmp, (neg ? -len : len) };
+    }
+
+    BigInt operator+(const BigInt& a, const BigInt& b)
+    {
+        if (a.m_len == 0) return b; if (b.m_len == 0) return a; // x + 0 = x
+
+        bool aNeg = a.m_len < 0, bNeg = b.m_len < 0;
+        if (aNeg == bNeg) return BigInt::addAbs(a, b, aNeg); // -x + -y = -(x + y)
+
+        int c = BigInt::compareAbs(a, b);
+        if (c == 0) return 0; // x-x = 0
+        if (c > 0) return BigInt::subAbs(a, b, aNeg); // abs(a) > abs(b); the result has the sign of a
+        return BigInt::subAbs(b, a, bNeg); // abs(a) < abs(b); a - b = -(b - a)
     }
 
     BigInt operator*(BigInt a, BigInt b)
@@ -296,46 +687,42 @@ namespace BigInts
     {
         if (a.m_len != b.m_len) return false; // compare the length of the integers
 
-        for (len_t i{ 0 }; i < a.m_len; ++i)
-        if (a.m_digits[i] != b.m_digits[i]) return false; // compare the digits
-
-        return true;
+        bool equal{ true };
+        streamBlocks(ABS_M(a.m_len), false, { a.m_digits, b.m_digits }, [&](len_t begin, len_t end)
+        {
+            equal = std::equal(a.m_digits + begin, a.m_digits + end, b.m_digits + begin); // compare the digits
+            return equal;
+        });
+        return equal;
     }
     bool operator<(const BigInt& a, const BigInt& b)
     {
         if (a.m_len < b.m_len) return true; // comepare the lengths
         if (a.m_len > b.m_len) return false;
 
-        for (len_t i{ ABS_M(a.m_len)-1 }; i >= 0; --i) // compare the digits
-        {
-            if (a.m_digits[i] < b.m_digits[i]) return true;
-            if (a.m_digits[i] > b.m_digits[i]) return false;
-        }
-
-        return false;
+        int c = BigInt::compareAbs(a, b); // compare the digits
+        return (a.m_len < 0 ? c > 0 : c < 0); // the larger negative number is the smaller one
     }
     bool operator>(const BigInt& a, const BigInt& b)
     {
         if (a.m_len < b.m_len) return false;
         if (a.m_len > b.m_len) return true;
 
-        for (len_t i{ ABS_M(a.m_len)-1 }; i >= 0; --i)
-        {
-            if (a.m_digits[i] < b.m_digits[i]) return false;
-            if (a.m_digits[i] > b.m_digits[i]) return true;
-        }
-
-        return false;
+        int c = BigInt::compareAbs(a, b);
+        return (a.m_len < 0 ? c < 0 : c > 0);
     }
 
     BigInt operator&(BigInt a, const BigInt& b)
     {
         if (a.m_len >= 0 && b.m_len >= 0)
         {
-            for (len_t i{ 0 }; i < std::min(a.m_len, b.m_len); ++i)
-            a.m_digits[i] &= b.m_digits[i];
-            for (len_t i{ std::min(a.m_len, b.m_len) }; i < a.m_len; ++i)
-            a.m_digits[i] = 0;
+            len_t mi = std::min(a.m_len, b.m_len);
+            streamBlocks(a.m_len, false, { a.m_digits, b.m_digits }, [&](len_t begin, len_t end)
+            {
+                for (len_t i{ begin }; i < end; ++i)
+                a.m_digits[i] = (i < mi ? a.m_digits[i] & b.m_digits[i] : 0);
+                return true;
+            });
         }
 
         while (a.m_len != 0 && a.m_digits[ABS_M(a.m_len)-1] == 0) // avoid leading zeroes
@@ -350,41 +737,28 @@ namespace BigInts
     BigInt operator>>(BigInt a, BigInt b)
     {
         assert ((b > 0 || b == 0) && "Cannot shift by a negative amount!");
-        if (a < b) return -((-a) >> b);
-        //std::cout << ".." << a << ' ' << b;
+        if (a.m_len < 0) return -((-a) >> b);
+
+        int64 shift = b.toInt64();
+        len_t big_shifts = shift / DIGIT_BITS_G; // whole digits
+        int small_shift = shift % DIGIT_BITS_G; // bits within a digit
+        if (big_shifts >= a.m_len) return {};
 
-        int big_shifts = 0;
-        while (b > DIGIT_BITS_G || b == DIGIT_BITS_G)
+        len_t len = a.m_len - big_shifts;
+        digit_t *tmp = allocDigits(len);
+        streamBlocks(len, false, { { a.m_digits, big_shifts }, tmp }, [&](len_t begin, len_t end)
         {
-            ++big_shifts; b = b - (BigInt)DIGIT_BITS_G;
-            if (big_shifts >= a.m_len)
+            for (len_t i{ begin }; i < end; ++i)
             {
-                return {};
+                int64 low = a.m_digits[i+big_shifts];
+                int64 high = (i+1 < len ? a.m_digits[i+1+big_shifts] : 0);
+                tmp[i] = ((low >> small_shift) | (high << (DIGIT_BITS_G-small_shift))) & (DIGIT_MAX_G-1);
             }
-        }
-        len_t len = a.m_len - big_shifts;
-        digit_t *tmp = new digit_t[len];
-        for (len_t i{ big_shifts }; i < a.m_len; ++i)
-        tmp[i-big_shifts] = a.m_digits[i];
-
-        //std::cout << ' ' << len << ' ' << big_shifts << '\n';
-
-        digit_t tmp_{ 0 };
-        for (len_t i{ len-1 }; i >= 0; --i)
-        {
-            digit_t tmp__ = tmp[i] & ((digit_t)pow(2, b.toInt64()+1) - 1);
-            tmp[i] >>= b.toInt64();
-            tmp[i] |= (tmp_ << (DIGIT_BITS_G-b.toInt64()));
-            tmp_ = tmp__;
-            //tmp[i-1] = tmp[i] & ((digit_t)pow(2, b.toInt64()+1) - 1);
-            //tmp[i] >>= (digit_t)b;
-        }
+            return true;
+        });
 
-        while (len != 0 && tmp[ABS_M(len)-1] == 0)
-        {
-            if (len > 0) --len;
-            if (len < 0) ++len;
-        }
+        while (len != 0 && tmp[len-1] == 0) --len; // avoid leading zeroes
+        if (len == 0) { freeDigits(tmp); return {}; }
 
         return { tmp, len };
     }
@@ -413,7 +787,582 @@ namespace BigInts
         return !(a == b);
     }
     BigInt operator-(const BigInt& a, const BigInt& b)
-    { return a + -b; } // a - b = a + -b
+    {
+        if (b.m_len == 0) return a; // x - 0 = x
+        if (a.m_len == 0) return -b;
+
+        bool aNeg = a.m_len < 0, bNeg = b.m_len < 0;
+        if (aNeg != bNeg) return BigInt::addAbs(a, b, aNeg); // x - -y = x + y, -x - y = -(x + y)
+
+        int c = BigInt::compareAbs(a, b);
+        if (c == 0) return 0; // x-x = 0
+        if (c > 0) return BigInt::subAbs(a, b, aNeg); // abs(a) > abs(b); the result has the sign of a
+        return BigInt::subAbs(b, a, !aNeg); // abs(a) < abs(b); a - b = -(b - a)
+    }
+
+
+
+    namespace // helpers for number theory, working directly on the digits of a BigInt
+    {
+        using limbs_t = std::vector<digit_t>; // digits of a non-negative number, least significant first
+
+        constexpr digit_t SMALL_PRIME_LIMIT_G = 8192; // trial divide / sieve by the primes below this
+        constexpr int64 SIEVE_WINDOW_G = 4096; // the amount of odd candidates nextPrime sieves at once
+
+        struct PrimeBatch // consecutive small primes whose product fits in 32 bits
+        {
+            uint64 product;
+            size_t first, last; // indices into smallPrimes()
+        };
+
+        const std::vector<digit_t>& smallPrimes() // the odd primes below SMALL_PRIME_LIMIT_G
+        {
+            static const std::vector<digit_t> primes = []
+            {
+                std::vector<char> composite(SMALL_PRIME_LIMIT_G, 0);
+                std::vector<digit_t> r;
+                for (digit_t p{ 3 }; p < SMALL_PRIME_LIMIT_G; p += 2)
+                {
+                    if (composite[p]) continue;
+                    r.push_back(p);
+                    for (digit_t q{ p*p }; q < SMALL_PRIME_LIMIT_G; q += 2*p) composite[q] = 1;
+                }
+                return r;
+            }();
+            return primes;
+        }
+        const std::vector<PrimeBatch>& primeBatches() // smallPrimes() grouped so one pass over n tests a whole group
+        {
+            static const std::vector<PrimeBatch> batches = []
+            {
+                const std::vector<digit_t>& primes = smallPrimes();
+                std::vector<PrimeBatch> r;
+                for (size_t i{ 0 }; i < primes.size();)
+                {
+                    PrimeBatch b{ 1, i, i };
+                    while (b.last < primes.size() && b.product * primes[b.last] <= 0xFFFFFFFFull)
+                        b.product *= primes[b.last++];
+                    r.push_back(b);
+                    i = b.last;
+                }
+                return r;
+            }();
+            return batches;
+        }
+
+        void trim(limbs_t& a) // avoid leading zeroes
+        {
+            while (!a.empty() && a.back() == 0) a.pop_back();
+        }
+        digit_t limbAt(const limbs_t& a, size_t i) // missing digits are zero
+        {
+            return (i < a.size() ? a[i] : 0);
+        }
+        size_t bitLength(const limbs_t& a)
+        {
+            size_t len = a.size();
+            while (len != 0 && a[len-1] == 0) --len;
+            if (len == 0) return 0;
+
+            size_t bits = (len-1)*DIGIT_BITS_G;
+            for (digit_t top{ a[len-1] }; top != 0; top >>= 1) ++bits;
+            return bits;
+        }
+        bool testBit(const limbs_t& a, size_t i)
+        {
+            return (limbAt(a, i / DIGIT_BITS_G) >> (i % DIGIT_BITS_G)) & 1;
+        }
+        int compare(const limbs_t& a, const limbs_t& b) // -1, 0 or 1 as a <, == or > b
+        {
+            for (size_t i{ std::max(a.size(), b.size()) }; i-- > 0;)
+            {
+                if (limbAt(a, i) < limbAt(b, i)) return -1;
+                if (limbAt(a, i) > limbAt(b, i)) return 1;
+            }
+            return 0;
+        }
+        bool isZero(const limbs_t& a)
+        {
+            for (digit_t d : a) if (d != 0) return false;
+            return true;
+        }
+        void addSmall(limbs_t& a, int64 v) // a += v, 0 <= v < 2^62
+        {
+            for (size_t i{ 0 }; v != 0; ++i)
+            {
+                if (i == a.size()) a.push_back(0);
+                v += a[i];
+                a[i] = v & DIGIT_MASK_G;
+                v >>= DIGIT_BITS_G;
+            }
+        }
+        void addInPlace(limbs_t& a, const limbs_t& b) // a += b
+        {
+            a.resize(std::max(a.size(), b.size()), 0);
+            digit_t carry{ 0 };
+            for (size_t i{ 0 }; i < a.size(); ++i)
+            {
+                digit_t d = a[i] + limbAt(b, i) + carry;
+                carry = d >> DIGIT_BITS_G;
+                a[i] = d & DIGIT_MASK_G;
+            }
+            if (carry) a.push_back(carry);
+        }
+        void subInPlace(limbs_t& a, const limbs_t& b) // a -= b, a >= b
+        {
+            digit_t borrow{ 0 };
+            for (size_t i{ 0 }; i < a.size(); ++i)
+            {
+                digit_t d = a[i] - limbAt(b, i) - borrow;
+                borrow = (d < 0);
+                a[i] = d + (borrow ? (digit_t)DIGIT_MAX_G : 0);
+            }
+            trim(a);
+        }
+        limbs_t shiftRight(const limbs_t& a, size_t bits)
+        {
+            size_t big = bits / DIGIT_BITS_G, small = bits % DIGIT_BITS_G;
+            if (big >= a.size()) return {};
+
+            limbs_t r(a.size() - big);
+            for (size_t i{ 0 }; i < r.size(); ++i)
+                r[i] = (digit_t)(((uint64)a[i+big] >> small | (uint64)limbAt(a, i+big+1) << (DIGIT_BITS_G - small)) & DIGIT_MASK_G);
+            trim(r);
+            return r;
+        }
+        uint64 modSmall(const limbs_t& a, uint64 m) // a mod m, m < 2^32
+        {
+            uint64 r{ 0 };
+            for (size_t i{ a.size() }; i-- > 0;)
+                r = ((r << DIGIT_BITS_G) | (uint64)a[i]) % m;
+            return r;
+        }
+
+        int jacobiSmall(int64 a, int64 n) // the Jacobi symbol (a/n), n odd and positive
+        {
+            a %= n;
+            int r{ 1 };
+            while (a != 0)
+            {
+                while (a % 2 == 0)
+                {
+                    a /= 2;
+                    if (n % 8 == 3 || n % 8 == 5) r = -r;
+                }
+                std::swap(a, n);
+                if (a % 4 == 3 && n % 4 == 3) r = -r;
+                a %= n;
+            }
+            return (n == 1 ? r : 0);
+        }
+        int jacobi(int64 a, const limbs_t& n) // the Jacobi symbol (a/n), n odd and larger than abs(a)
+        {
+            int r{ 1 };
+            int nMod8 = n[0] & 7;
+            if (a < 0)
+            {
+                a = -a;
+                if (nMod8 % 4 == 3) r = -r; // (-1/n)
+            }
+            while (a % 2 == 0)
+            {
+                a /= 2;
+                if (nMod8 == 3 || nMod8 == 5) r = -r; // (2/n)
+            }
+            if (a == 1) return r;
+            if (a % 4 == 3 && nMod8 % 4 == 3) r = -r; // quadratic reciprocity
+            return r * jacobiSmall(modSmall(n, a), a);
+        }
+
+        bool isSquare(const limbs_t& n)
+        {
+            static const auto residues = [](uint64 m) // the squares mod m
+            {
+                std::vector<char> r(m, 0);
+                for (uint64 i{ 0 }; i < m; ++i) r[i*i % m] = 1;
+                return r;
+            };
+            static const std::vector<char> sq64 = residues(64), sq45045 = residues(45045); // 45045 = 9*5*7*11*13
+            if (!sq64[n.empty() ? 0 : n[0] & 63] || !sq45045[modSmall(n, 45045)]) return false;
+
+            // bit-by-bit integer square root
+            limbs_t num{ n }, res{}, bit(n.size(), 0);
+            trim(num);
+            if (num.empty()) return true;
+            size_t top = (bitLength(num)-1) & ~(size_t)1; // the highest power of 4 <= n
+            bit[top / DIGIT_BITS_G] = (digit_t)1 << (top % DIGIT_BITS_G);
+            while (!isZero(bit))
+            {
+                limbs_t t{ res };
+                addInPlace(t, bit);
+                if (compare(num, t) >= 0)
+                {
+                    subInPlace(num, t);
+                    res = shiftRight(res, 1);
+                    addInPlace(res, bit);
+                }
+                else res = shiftRight(res, 1);
+                bit = shiftRight(bit, 2);
+            }
+            return isZero(num);
+        }
+
+        class Montgomery // arithmetic mod an odd n > 1, with numbers kept as x*R mod n, R = 2^(DIGIT_BITS_G*k)
+        {
+            limbs_t m_n;
+            size_t m_k;
+            digit_t m_nInv; // -n^-1 mod 2^DIGIT_BITS_G
+            limbs_t m_r2; // R^2 mod n
+
+        public:
+            limbs_t one, minusOne;
+
+            explicit Montgomery(const limbs_t& n) : m_n{ n }
+            {
+                trim(m_n);
+                m_k = m_n.size();
+
+                uint64 inv = m_n[0]; // correct to 3 bits, since n is odd
+                for (int i{ 0 }; i < 4; ++i) inv *= 2 - m_n[0]*inv; // each step doubles the correct bits
+                m_nInv = (digit_t)(-inv & DIGIT_MASK_G);
+
+                m_r2.assign(m_k, 0);
+                m_r2[0] = 1;
+                for (size_t i{ 0 }; i < 2*DIGIT_BITS_G*m_k; ++i) m_r2 = add(m_r2, m_r2);
+
+                one = fromInt(1);
+                minusOne = neg(one);
+            }
+
+            limbs_t add(const limbs_t& a, const limbs_t& b) const
+            {
+                limbs_t r(m_k);
+                digit_t carry{ 0 };
+                for (size_t i{ 0 }; i < m_k; ++i)
+                {
+                    digit_t d = a[i] + b[i] + carry;
+                    carry = d >> DIGIT_BITS_G;
+                    r[i] = d & DIGIT_MASK_G;
+                }
+                if (carry || compare(r, m_n) >= 0) subNoTrim(r, m_n);
+                return r;
+            }
+            limbs_t sub(const limbs_t& a, const limbs_t& b) const
+            {
+                limbs_t r{ a };
+                if (subNoTrim(r, b)) // went negative, so wrap around
+                {
+                    digit_t carry{ 0 };
+                    for (size_t i{ 0 }; i < m_k; ++i)
+                    {
+                        digit_t d = r[i] + m_n[i] + carry;
+                        carry = d >> DIGIT_BITS_G;
+                        r[i] = d & DIGIT_MASK_G;
+                    }
+                }
+                return r;
+            }
+            limbs_t neg(const limbs_t& a) const
+            {
+                return sub(limbs_t(m_k, 0), a);
+            }
+            limbs_t half(const limbs_t& a) const // a/2 mod n; the same in and out of Montgomery form
+            {
+                limbs_t r{ a };
+                digit_t carry{ 0 };
+                if (r[0] & 1) // odd, so add n to make it even
+                {
+                    for (size_t i{ 0 }; i < m_k; ++i)
+                    {
+                        digit_t d = r[i] + m_n[i] + carry;
+                        carry = d >> DIGIT_BITS_G;
+                        r[i] = d & DIGIT_MASK_G;
+                    }
+                }
+                for (size_t i{ 0 }; i < m_k; ++i)
+                {
+                    digit_t above = (i+1 < m_k ? r[i+1] : carry);
+                    r[i] = (r[i] >> 1) | ((above & 1) << (DIGIT_BITS_G-1));
+                }
+                return r;
+            }
+            limbs_t mul(const limbs_t& a, const limbs_t& b) const // a*b/R mod n
+            {
+                std::vector<uint64> t(m_k+2, 0);
+                for (size_t i{ 0 }; i < m_k; ++i)
+                {
+                    uint64 c{ 0 }, s;
+                    for (size_t j{ 0 }; j < m_k; ++j) // t += a*b[i]
+                    {
+                        s = t[j] + (uint64)a[j]*(uint64)b[i] + c;
+                        t[j] = s & DIGIT_MASK_G;
+                        c = s >> DIGIT_BITS_G;
+                    }
+                    s = t[m_k] + c;
+                    t[m_k] = s & DIGIT_MASK_G;
+                    t[m_k+1] = s >> DIGIT_BITS_G;
+
+                    uint64 m = (t[0]*(uint64)m_nInv) & DIGIT_MASK_G; // (t + m*n) is divisible by 2^DIGIT_BITS_G
+                    s = t[0] + m*(uint64)m_n[0];
+                    c = s >> DIGIT_BITS_G;
+                    for (size_t j{ 1 }; j < m_k; ++j) // t = (t + m*n) >> DIGIT_BITS_G
+                    {
+                        s = t[j] + m*(uint64)m_n[j] + c;
+                        t[j-1] = s & DIGIT_MASK_G;
+                        c = s >> DIGIT_BITS_G;
+                    }
+                    s = t[m_k] + c;
+                    t[m_k-1] = s & DIGIT_MASK_G;
+                    t[m_k] = t[m_k+1] + (s >> DIGIT_BITS_G);
+                }
+
+                limbs_t r(m_k);
+                for (size_t i{ 0 }; i < m_k; ++i) r[i] = (digit_t)t[i];
+                if (t[m_k] != 0 || compare(r, m_n) >= 0) subNoTrim(r, m_n);
+                return r;
+            }
+            limbs_t fromInt(int64 v) const // v mod n in Montgomery form, abs(v) < 2^DIGIT_BITS_G and < n
+            {
+                limbs_t r(m_k, 0);
+                r[0] = (digit_t)ABS_M(v);
+                r = mul(r, m_r2);
+                return (v < 0 ? neg(r) : r);
+            }
+            limbs_t pow(const limbs_t& base, const limbs_t& exp) const // base^exp, fixed 4-bit windows
+            {
+                limbs_t table[16];
+                table[0] = one;
+                for (int i{ 1 }; i < 16; ++i) table[i] = mul(table[i-1], base);
+
+                limbs_t r{ one };
+                bool first{ true };
+                for (size_t w{ (bitLength(exp)+3)/4 }; w-- > 0;)
+                {
+                    if (!first) for (int i{ 0 }; i < 4; ++i) r = mul(r, r);
+                    int bits{ 0 };
+                    for (int i{ 3 }; i >= 0; --i) bits = (bits << 1) | testBit(exp, 4*w + i);
+                    if (bits) { r = (first ? table[bits] : mul(r, table[bits])); first = false; }
+                }
+                return r;
+            }
+
+        private:
+            bool subNoTrim(limbs_t& a, const limbs_t& b) const // a -= b mod 2^(DIGIT_BITS_G*k); returns the borrow
+            {
+                digit_t borrow{ 0 };
+                for (size_t i{ 0 }; i < m_k; ++i)
+                {
+                    digit_t d = a[i] - b[i] - borrow;
+                    borrow = (d < 0);
+                    a[i] = d + (borrow ? (digit_t)DIGIT_MAX_G : 0);
+                }
+                return borrow;
+            }
+        };
+
+        enum class Trial { composite, prime, unknown };
+        Trial trialDivide(const limbs_t& n) // n > 1
+        {
+            if (!(n[0] & 1)) return (n.size() == 1 && n[0] == 2 ? Trial::prime : Trial::composite);
+
+            const std::vector<digit_t>& primes = smallPrimes();
+            for (const PrimeBatch& b : primeBatches())
+            {
+                uint64 r = modSmall(n, b.product); // one pass over n for the whole batch
+                for (size_t i{ b.first }; i < b.last; ++i)
+                if (r % primes[i] == 0) return (n.size() == 1 && n[0] == primes[i] ? Trial::prime : Trial::composite);
+            }
+
+            // SMALL_PRIME_LIMIT_G^2 fits in one digit; below that, having no small factor means prime
+            if (n.size() == 1 && n[0] < SMALL_PRIME_LIMIT_G*SMALL_PRIME_LIMIT_G) return Trial::prime;
+            return Trial::unknown;
+        }
+
+        bool strongProbablePrime(const Montgomery& m, const limbs_t& base, const limbs_t& d, size_t s)
+        {
+            // Miller-Rabin: n-1 = d*2^s, n passes if base^d == 1 or base^(d*2^r) == -1 for some r < s
+            limbs_t x = m.pow(base, d);
+            if (x == m.one || x == m.minusOne) return true;
+            for (size_t r{ 1 }; r < s; ++r)
+            {
+                x = m.mul(x, x);
+                if (x == m.minusOne) return true;
+                if (x == m.one) return false;
+            }
+            return false;
+        }
+        bool strongLucasProbablePrime(const Montgomery& m, const limbs_t& n)
+        {
+            // Selfridge's method A: the first D in 5, -7, 9, -11, ... with (D/n) == -1, P = 1, Q = (1-D)/4
+            int64 D{ 5 };
+            for (int tries{ 0 };; ++tries, D = (D > 0 ? -D-2 : -D+2))
+            {
+                int j = jacobi(D, n);
+                if (j == -1) break;
+                if (j == 0) return false; // n > abs(D), so n shares a factor with D
+                if (tries == 8 && isSquare(n)) return false; // a square never gives -1
+            }
+            int64 Q = (1-D)/4;
+
+            limbs_t d{ n };
+            addSmall(d, 1);
+            size_t s{ 0 };
+            while (!testBit(d, s)) ++s;
+            d = shiftRight(d, s); // n+1 = d*2^s
+
+            limbs_t mD = m.fromInt(D), mQ = m.fromInt(Q);
+            limbs_t U{ m.one }, V{ m.one }, Qk{ mQ }; // U_1, V_1 and Q^1
+            for (size_t i{ bitLength(d)-1 }; i-- > 0;)
+            {
+                U = m.mul(U, V); // U_2k = U_k*V_k
+                V = m.sub(m.mul(V, V), m.add(Qk, Qk)); // V_2k = V_k^2 - 2Q^k
+                Qk = m.mul(Qk, Qk);
+                if (testBit(d, i))
+                {
+                    limbs_t U1 = m.half(m.add(U, V)); // U_k+1 = (P*U_k + V_k)/2
+                    V = m.half(m.add(m.mul(mD, U), V)); // V_k+1 = (D*U_k + P*V_k)/2
+                    U = U1;
+                    Qk = m.mul(Qk, mQ);
+                }
+            }
+
+            limbs_t zero(U.size(), 0);
+            if (U == zero || V == zero) return true;
+            for (size_t r{ 1 }; r < s; ++r)
+            {
+                V = m.sub(m.mul(V, V), m.add(Qk, Qk)); // V_2k = V_k^2 - 2Q^k
+                if (V == zero) return true;
+                Qk = m.mul(Qk, Qk);
+            }
+            return false;
+        }
+        bool bpsw(const limbs_t& n, int rounds) // n odd, with no factors below SMALL_PRIME_LIMIT_G
+        {
+            Montgomery m{ n };
+
+            limbs_t d{ n };
+            d[0] -= 1; // n is odd, so this can't borrow
+            size_t s{ 0 };
+            while (!testBit(d, s)) ++s;
+            d = shiftRight(d, s); // n-1 = d*2^s
+
+            if (!strongProbablePrime(m, m.fromInt(2), d, s)) return false;
+            const std::vector<digit_t>& primes = smallPrimes();
+            for (int i{ 0 }; i < rounds && i < (int)primes.size(); ++i) // extra Miller-Rabin bases 3, 5, 7, ...
+            if (!strongProbablePrime(m, m.fromInt(primes[i]), d, s)) return false;
+
+            return strongLucasProbablePrime(m, n);
+        }
+        bool probablePrime(const limbs_t& n, int rounds) // n > 1
+        {
+            Trial t = trialDivide(n);
+            if (t != Trial::unknown) return t == Trial::prime;
+            return bpsw(n, rounds);
+        }
+
+        limbs_t nextPrimeFrom(limbs_t c, unsigned threads) // the smallest prime >= c, c odd and > 1
+        {
+            const std::vector<digit_t>& primes = smallPrimes();
+            std::vector<char> composite(SIEVE_WINDOW_G);
+            for (;; addSmall(c, 2*SIEVE_WINDOW_G))
+            {
+                // sieve the window c, c+2, ..., c+2(SIEVE_WINDOW_G-1) by every small prime at once
+                int64 small = (c.size() == 1 ? c[0] : -1); // the window may contain the small primes themselves
+                std::fill(composite.begin(), composite.end(), 0);
+                for (const PrimeBatch& b : primeBatches())
+                {
+                    uint64 r = modSmall(c, b.product);
+                    for (size_t j{ b.first }; j < b.last; ++j)
+                    {
+                        int64 p = primes[j];
+                        int64 i = (p - (int64)(r % p)) % p * ((p+1)/2) % p; // c + 2i == 0 mod p
+                        for (; i < SIEVE_WINDOW_G; i += p)
+                        if (small < 0 || small + 2*i != p) composite[i] = 1;
+                    }
+                }
+
+                std::vector<limbs_t> candidates;
+                for (int64 i{ 0 }; i < SIEVE_WINDOW_G; ++i)
+                {
+                    if (composite[i]) continue;
+                    limbs_t n{ c };
+                    addSmall(n, 2*i);
+                    if (n.size() == 1 && n[0] < SMALL_PRIME_LIMIT_G*SMALL_PRIME_LIMIT_G) return n; // the sieve was exact
+                    candidates.push_back(n);
+                }
+
+                // test the survivors in order, `threads` at a time
+                for (size_t i{ 0 }; i < candidates.size(); i += std::max(threads, 1u))
+                {
+                    size_t count = std::min<size_t>(std::max(threads, 1u), candidates.size() - i);
+                    std::vector<char> isPrime(count, 0);
+                    if (count == 1) isPrime[0] = bpsw(candidates[i], 0);
+                    else
+                    {
+                        std::vector<std::thread> pool;
+                        for (size_t j{ 0 }; j < count; ++j)
+                            pool.emplace_back([&, j] { isPrime[j] = bpsw(candidates[i+j], 0); });
+                        for (std::thread& t : pool) t.join();
+                    }
+                    for (size_t j{ 0 }; j < count; ++j)
+                    if (isPrime[j]) return candidates[i+j];
+                }
+            }
+        }
+    }
+
+    BigInt randomBits(len_t bits, std::mt19937_64& rng) // uniform in [0, 2^bits)
+    {
+        assert (bits >= 0 && "Can't generate a negative amount of bits!");
+        std::vector<digit_t> limbs((bits + DIGIT_BITS_G-1) / DIGIT_BITS_G);
+
+        for (size_t i{ 0 }; i < limbs.size(); i += 2) // every draw fills two digits
+        {
+            uint64 r = rng();
+            limbs[i] = r & DIGIT_MASK_G;
+            if (i+1 < limbs.size()) limbs[i+1] = (r >> DIGIT_BITS_G) & DIGIT_MASK_G;
+        }
+        if (bits % DIGIT_BITS_G != 0) limbs.back() &= ((digit_t)1 << (bits % DIGIT_BITS_G)) - 1;
+
+        return BigInt::fromLimbs(limbs);
+    }
+    BigInt randomBelow(const BigInt& bound, std::mt19937_64& rng) // uniform in [0, bound)
+    {
+        assert (bound > 0 && "Can only generate numbers below a positive bound!");
+        len_t bits = bitLength(bound.limbs());
+
+        BigInt r;
+        do r = randomBits(bits, rng); // succeeds at least half the time
+        while (!(r < bound));
+        return r;
+    }
+    BigInt randomPrime(len_t bits, std::mt19937_64& rng, unsigned threads) // a random prime of exactly `bits` bits
+    {
+        assert (bits >= 2 && "There are no primes with less than two bits!");
+        for (;;)
+        {
+            std::vector<digit_t> limbs = randomBits(bits, rng).limbs();
+            limbs.resize((bits + DIGIT_BITS_G-1) / DIGIT_BITS_G, 0);
+            limbs.back() |= (digit_t)1 << ((bits-1) % DIGIT_BITS_G); // exactly `bits` bits
+            limbs[0] |= 1; // odd
+
+            limbs = nextPrimeFrom(limbs, threads);
+            if ((len_t)bitLength(limbs) == bits) return BigInt::fromLimbs(limbs);
+        }
+    }
+    bool isProbablePrime(const BigInt& n, int rounds) // trial division, then BPSW and `rounds` extra Miller-Rabin bases
+    {
+        if (n < 2) return false;
+        return probablePrime(n.limbs(), rounds);
+    }
+    BigInt nextPrime(const BigInt& n, unsigned threads) // the smallest prime > n
+    {
+        if (n < 2) return 2;
+
+        std::vector<digit_t> c = n.limbs();
+        addSmall(c, (c[0] & 1) ? 2 : 1); // the next odd number
+        return BigInt::fromLimbs(nextPrimeFrom(c, threads));
+    }
 
 
 
@@ -427,10 +1376,10 @@ namespace BigInts
         const BigInt TEN{ DIGIT_MAX_G };
         const BigInt ELEVEN{ DIGIT_MAX_G+1 };
         const BigInt EIGHTEEN{ DIGIT_MAX_G*2 - 2 };
-        digit_t *tmp = new digit_t[2];
+        digit_t *tmp = allocDigits(2);
         tmp[0] = DIGIT_MAX_G-1; tmp[1] = DIGIT_MAX_G-1;
         const BigInt NINETY_NINE{ tmp, 2 };
-        tmp = new digit_t[3];
+        tmp = allocDigits(3);
         tmp[0] = 0; tmp[1] = 0; tmp[2] = 1;
         const BigInt HUNDRED{ tmp, 3 };
 
@@ -441,10 +1390,10 @@ namespace BigInts
         const BigInt N_TEN{ -DIGIT_MAX_G };
         const BigInt N_ELEVEN{ -DIGIT_MAX_G-1 };
         const BigInt N_EIGHTEEN{ -DIGIT_MAX_G*2 + 2 };
-        tmp = new digit_t[2];
+        tmp = allocDigits(2);
         tmp[0] = DIGIT_MAX_G-1; tmp[1] = DIGIT_MAX_G-1;
         const BigInt N_NINETY_NINE{ tmp, -2 };
-        tmp = new digit_t[3];
+        tmp = allocDigits(3);
         tmp[0] = 0; tmp[1] = 0; tmp[2] = 1;
         const BigInt N_HUNDRED{ tmp, -3 };
 
@@ -531,13 +1480,13 @@ namespace BigInts
         const BigInt FIVE{ DIGIT_MAX_G >> 1 };
         const BigInt TEN{ DIGIT_MAX_G };
         const BigInt TWENTY{ DIGIT_MAX_G*2 };
-        digit_t *tmp = new digit_t[2];
+        digit_t *tmp = allocDigits(2);
         tmp[0] = 0; tmp[1] = DIGIT_MAX_G >> 2;
         const BigInt TWENTY_FIVE{ tmp, 2 };
-        tmp = new digit_t[2];
+        tmp = allocDigits(2);
         tmp[0] = 0; tmp[1] = DIGIT_MAX_G>>1;
         const BigInt FIFTY{ tmp, 2 };
-        tmp = new digit_t[3];
+        tmp = allocDigits(3);
         tmp[0] = 0; tmp[1] = 0; tmp[2] = 1;
         const BigInt HUNDRED{ tmp, 3 };
 
@@ -549,13 +1498,13 @@ namespace BigInts
         const BigInt N_FIVE{ -(DIGIT_MAX_G >> 1) };
         const BigInt N_TEN{ -DIGIT_MAX_G };
         const BigInt N_TWENTY{ -DIGIT_MAX_G*2 };
-        tmp = new digit_t[2];
+        tmp = allocDigits(2);
         tmp[0] = 0; tmp[1] = DIGIT_MAX_G >> 2;
         const BigInt N_TWENTY_FIVE{ tmp, -2 };
-        tmp = new digit_t[2];
+        tmp = allocDigits(2);
         tmp[0] = 0; tmp[1] = DIGIT_MAX_G>>1;
         const BigInt N_FIFTY{ tmp, -2 };
-        tmp = new digit_t[3];
+        tmp = allocDigits(3);
         tmp[0] = 0; tmp[1] = 0; tmp[2] = 1;
         const BigInt N_HUNDRED{ tmp, -3 };
 
@@ -634,4 +1583,134 @@ namespace BigInts
         std::cout << "-2 * -10 == 20   : " << (N_TWO * N_TEN == TWENTY) << '\n'; // len(a * b) == len(b)
         std::cout << "-2 * -50 == 100  : " << (N_TWO * N_FIFTY == HUNDRED) << '\n'; // len(a * b) < len(b)
     }
+
+    void primalityTest()
+    {
+        const BigInt M61{ BigInt::fromString(std::string(61, '1'), 2) }; // Mersenne numbers 2^p - 1 are p ones
+        const BigInt M67{ BigInt::fromString(std::string(67, '1'), 2) };
+        const BigInt M89{ BigInt::fromString(std::string(89, '1'), 2) };
+        const BigInt TWO_64{ BigInt::fromString("10000000000000000", 16) }; // 2^64
+        std::mt19937_64 rng{ 42 };
+
+        std::cout << std::boolalpha;
+        // small numbers are decided by trial division
+        std::cout << "isPrime(-7) == false             : " << (isProbablePrime(-7) == false) << '\n';
+        std::cout << "isPrime(1) == false              : " << (isProbablePrime(1) == false) << '\n';
+        std::cout << "isPrime(2) == true               : " << (isProbablePrime(2) == true) << '\n';
+        std::cout << "isPrime(561) == false            : " << (isProbablePrime(561) == false) << '\n'; // Carmichael number
+        std::cout << "isPrime(8191) == true            : " << (isProbablePrime(8191) == true) << '\n';
+        // larger numbers need BPSW
+        std::cout << "isPrime(67108859) == true        : " << (isProbablePrime(67108859) == true) << '\n';
+        std::cout << "isPrime(8209^2) == false         : " << (isProbablePrime((int64)8209*8209) == false) << '\n'; // square
+        std::cout << "isPrime(8209*8219) == false      : " << (isProbablePrime((int64)8209*8219) == false) << '\n';
+        std::cout << "isPrime(2^61-1) == true          : " << (isProbablePrime(M61) == true) << '\n';
+        std::cout << "isPrime(2^67-1) == false         : " << (isProbablePrime(M67) == false) << '\n';
+        std::cout << "isPrime(2^89-1) == true          : " << (isProbablePrime(M89, 4) == true) << '\n';
+        // nextPrime
+        std::cout << "nextPrime(0) == 2                : " << (nextPrime(0) == 2) << '\n';
+        std::cout << "nextPrime(2) == 3                : " << (nextPrime(2) == 3) << '\n';
+        std::cout << "nextPrime(8190) == 8191          : " << (nextPrime(8190) == 8191) << '\n';
+        std::cout << "nextPrime(2^64) == 2^64+13       : " << (nextPrime(TWO_64) == TWO_64 + 13) << '\n';
+        std::cout << "nextPrime(2^64, 4) == 2^64+13    : " << (nextPrime(TWO_64, 4) == TWO_64 + 13) << '\n';
+        // random numbers
+        std::cout << "randomBits(0) == 0               : " << (randomBits(0, rng) == 0) << '\n';
+        std::cout << "randomBits(64) < 2^64            : " << (randomBits(64, rng) < TWO_64) << '\n';
+        std::cout << "randomBelow(7) < 7               : " << (randomBelow(7, rng) < 7) << '\n';
+        std::cout << "isPrime(randomPrime(256))        : " << isProbablePrime(randomPrime(256, rng)) << '\n';
+    }
+
+    void storageTest()
+    {
+        setMappedThreshold(1); // every digit goes to a temporary file
+
+        const BigInt TWO_64{ BigInt::fromString("10000000000000000", 16) }; // 2^64
+        const BigInt BIG{ BigInt::fromString("1000000000000000d", 16) }; // 2^64+13
+        std::mt19937_64 rng{ 27 };
+        const BigInt X{ randomBits(DIGIT_BITS_G*(STREAM_BLOCK_G+5) - 3, rng) }; // spans two stream blocks
+        const BigInt Y{ randomBits(DIGIT_BITS_G*(STREAM_BLOCK_G-5), rng) };
+        const BigInt HALF{ X >> 1 };
+
+        std::cout << std::boolalpha;
+        // the backend
+        std::cout << "isMapped(2^64+13)                   : " << isMapped(BIG.m_digits) << '\n';
+        digit_t *tmp = allocDigits(3);
+        tmp[0] = 13; tmp[1] = 0; tmp[2] = 16;
+        const BigInt FROM_LIST{ tmp, 3 };
+        std::cout << "{ 13, 0, 16 } == 2^64+13            : " << (FROM_LIST == BIG) << '\n';
+        BigInt kept{ BIG };
+        setTempDirectory("/nonexistent"); // every allocation now throws std::bad_alloc
+        bool threw{ false };
+        try { kept = Y; }
+        catch (const std::bad_alloc&) { threw = true; }
+        setTempDirectory("");
+        std::cout << "failed assignment keeps old value   : " << (threw && kept == BIG) << '\n';
+        // add, subtract, compare
+        std::cout << "(2^64+13) - 2^64 == 13              : " << (BIG - TWO_64 == 13) << '\n';
+        std::cout << "2^64 - (2^64+13) == -13             : " << (TWO_64 - BIG == -13) << '\n';
+        std::cout << "(X + Y) - Y == X                    : " << ((X + Y) - Y == X) << '\n';
+        std::cout << "(X - Y) + Y == X                    : " << ((X - Y) + Y == X) << '\n';
+        std::cout << "X - X == 0                          : " << (X - X == 0) << '\n';
+        std::cout << "X + Y > X                           : " << (X + Y > X) << '\n';
+        std::cout << "X - 1 < X                           : " << (X - 1 < X) << '\n';
+        std::cout << "-X < -(X - 1)                       : " << (-X < -(X - 1)) << '\n';
+        std::cout << "-5 < -3                             : " << (BigInt{ -5 } < -3) << '\n';
+        std::cout << "-3 > -5                             : " << (BigInt{ -3 } > -5) << '\n';
+        std::cout << "!(-3 < -5)                          : " << !(BigInt{ -3 } < -5) << '\n';
+        std::cout << "-(2^64+13) < -2^64                  : " << (-BIG < -TWO_64) << '\n';
+        std::cout << "-2^64 > -(2^64+13)                  : " << (-TWO_64 > -BIG) << '\n';
+        // & and >>
+        std::cout << "(2^64+13) & 2^64 == 2^64            : " << ((BIG & TWO_64) == TWO_64) << '\n';
+        std::cout << "X & X == X                          : " << ((X & X) == X) << '\n';
+        std::cout << "(2^64+13) >> 31 == 2^33             : " << ((BIG >> 31) == 8589934592LL) << '\n';
+        std::cout << "(2^64+13) >> 2 == 2^62+3            : " << ((BIG >> 2) == 4611686018427387907LL) << '\n';
+        std::cout << "-(2^64+13) >> 31 == -2^33           : " << ((-BIG >> 31) == -8589934592LL) << '\n';
+        std::cout << "1 >> 5 == 0                         : " << ((BigInt{ 1 } >> 5) == 0) << '\n';
+        std::cout << "(X >> 1) * 2 + (X & 1) == X         : " << (HALF + HALF + (X & 1) == X) << '\n';
+        std::cout << "(X >> 31) >> 29 == X >> 60          : " << (((X >> 31) >> 29) == (X >> 60)) << '\n';
+
+        setMappedThreshold(MAPPED_THRESHOLD_G);
+    }
+
+    void ioTest()
+    {
+        const BigInt TWO_64{ BigInt::fromString("10000000000000000", 16) }; // 2^64
+        const BigInt BIG{ BigInt::fromString("1000000000000000d", 16) }; // 2^64+13
+        std::stringstream ss;
+
+        std::cout << std::boolalpha;
+        // toString / fromString
+        std::cout << "toString(0, 16) == 0                 : " << (BigInt{ 0 }.toString(16) == "0") << '\n';
+        std::cout << "toString(-255, 16) == -ff            : " << (BigInt{ -255 }.toString(16) == "-ff") << '\n';
+        std::cout << "toString(2^64+13, 2)                 : " << (BIG.toString(2) == "1" + std::string(60, '0') + "1101") << '\n';
+        std::cout << "toString(2^64+13, 32, true)          : " << (BIG.toString(32, true) == "G00000000000D") << '\n';
+        std::cout << "toString(2^64+13) == 184...629       : " << (BIG.toString() == "18446744073709551629") << '\n';
+        std::cout << "toString(2^64+13, 36)                : " << (BIG.toString(36) == "3w5e11264sgst") << '\n';
+        std::cout << "fromString(-0x1000000000000000d, 16) : " << (BigInt::fromString("-0x1000000000000000d", 16) == -BIG) << '\n';
+        std::cout << "fromString(+2000...015, 8)           : " << (BigInt::fromString("+2000000000000000000015", 8) == BIG) << '\n';
+        std::cout << "fromString(184...629)                : " << (BigInt::fromString("18446744073709551629") == BIG) << '\n';
+        bool threw{ false };
+        try { BigInt{ 123456789 }.toString(1); }
+        catch (const std::invalid_argument&) { threw = true; }
+        std::cout << "toString(x, 1) throws                : " << threw << '\n';
+        threw = false;
+        try { BigInt::fromString("10", 37); }
+        catch (const std::invalid_argument&) { threw = true; }
+        std::cout << "fromString(10, 37) throws            : " << threw << '\n';
+        // streams
+        ss.str(""); ss << std::hex << BIG;
+        std::cout << "hex << 2^64+13                       : " << (ss.str() == "1000000000000000d") << '\n';
+        ss.str(""); ss << std::oct << std::showbase << BIG;
+        std::cout << "oct << showbase << 2^64+13           : " << (ss.str() == "02000000000000000000015") << '\n';
+        ss.str(""); ss << std::hex << std::showbase << std::uppercase << -BIG;
+        std::cout << "hex << showbase << uppercase << -BIG : " << (ss.str() == "-0X1000000000000000D") << '\n';
+        ss.str(""); ss << std::dec << std::noshowbase << std::setw(6) << std::setfill('*') << BigInt{ 42 };
+        std::cout << "setw(6) << 42 == ****42              : " << (ss.str() == "****42") << '\n';
+        BigInt a, b;
+        ss.clear(); ss.str(" -0x1000000000000000D 18446744073709551629");
+        ss >> std::hex >> a >> std::dec >> b;
+        std::cout << "hex >> a == -BIG, dec >> b == BIG    : " << (a == -BIG && b == BIG) << '\n';
+        ss.clear(); ss.str("zz");
+        ss >> a;
+        std::cout << "zz >> a fails                        : " << (ss.fail() && a == -BIG) << '\n';
+    }
 }
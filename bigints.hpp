@@ -1,6 +1,9 @@
 #include <tuple>
 #include <cmath>
 #include <string>
+#include <iosfwd>
+#include <vector>
+#include <random>
 
 #ifndef RUAN_BIGINTS_HPP
 #define RUAN_BIGINTS_HPP
@@ -8,11 +11,13 @@
 namespace BigInts
 {
     using int64 = long long;
+    using uint64 = unsigned long long;
 
     using digit_t = int32_t;
-    using len_t = int;
+    using len_t = int64; // the sign of a BigInt is stored in its length
     constexpr int DIGIT_BITS_G = 30;
     constexpr int64 DIGIT_MAX_G = (int64)powl(2,DIGIT_BITS_G);
+    constexpr digit_t DIGIT_MASK_G = (digit_t)(DIGIT_MAX_G - 1);
 
     class BigInt
     {
@@ -20,22 +25,34 @@ namespace BigInts
         len_t m_len;
 
         BigInt(digit_t *list, len_t len); // Make a BigInt from a list
+        static BigInt fromLimbs(std::vector<digit_t> limbs, bool neg = false); // Make a BigInt from its digits
+        std::vector<digit_t> limbs() const; // the digits of abs(*this), least significant first
+
+        static int compareAbs(const BigInt& a, const BigInt& b); // -1, 0 or 1 as abs(a) <, == or > abs(b)
+        static BigInt addAbs(const BigInt& a, const BigInt& b, bool neg); // abs(a) + abs(b), negated if neg
+        static BigInt subAbs(const BigInt& a, const BigInt& b, bool neg); // abs(a) - abs(b), negated if neg
     public:
         BigInt(); // 0
         BigInt(const BigInt& other); // copy another BigInt
         BigInt& operator=(const BigInt& other); // copy asygnment
+        BigInt(BigInt&& other) noexcept; // take over the digits of another BigInt
+        BigInt& operator=(BigInt&& other) noexcept; // move asygnment
         BigInt(int64 i); // make a BigInt form an integer
         ~BigInt();
 
         int64 toInt64() const;
         bool toBool() const;
         std::string toStr() const;
+        std::string toString(int base = 10, bool upper = false) const; // the digits in base 2-36 (else throws std::invalid_argument); linear time for powers of two
+        static BigInt fromString(const std::string& str, int base = 10); // an optional sign, then digits in base 2-36; throws std::invalid_argument otherwise
 
         BigInt operator-() const;
         BigInt& operator++();
 
-        //friend std::ostream& operator<<(std::ostream& out, const BigInt& i);
+        friend std::ostream& operator<<(std::ostream& out, const BigInt& i); // follows std::hex, std::oct, std::showbase, ...
+        friend std::istream& operator>>(std::istream& in, BigInt& i);
         friend BigInt operator+(const BigInt& a, const BigInt& b);
+        friend BigInt operator-(const BigInt& a, const BigInt& b);
         friend BigInt operator*(BigInt a, BigInt b);
         friend std::tuple<BigInt, BigInt> divMod(BigInt a, BigInt b);
         friend bool operator==(const BigInt& a, const BigInt& b);
@@ -43,11 +60,20 @@ namespace BigInts
         friend bool operator>(const BigInt& a, const BigInt& b);
         friend BigInt operator&(BigInt a, const BigInt& b);
         friend BigInt operator>>(BigInt a, BigInt b);
+        friend BigInt randomBits(len_t bits, std::mt19937_64& rng);
+        friend BigInt randomBelow(const BigInt& bound, std::mt19937_64& rng);
+        friend BigInt randomPrime(len_t bits, std::mt19937_64& rng, unsigned threads);
+        friend bool isProbablePrime(const BigInt& n, int rounds);
+        friend BigInt nextPrime(const BigInt& n, unsigned threads);
         friend void additionTest();
         friend void multiplicationTest();
+        friend void primalityTest();
+        friend void storageTest();
+        friend void ioTest();
     };
 
     std::ostream& operator<<(std::ostream& out, const BigInt& i);
+    std::istream& operator>>(std::istream& in, BigInt& i);
     std::tuple<BigInt, BigInt> divMod(BigInt a, BigInt b);
 
     BigInt operator/(const BigInt& a, const BigInt& b);
@@ -56,5 +82,11 @@ namespace BigInts
     BigInt& operator>>=(BigInt& a, const BigInt& b);
     bool operator!=(const BigInt& a, const BigInt& b);
     BigInt operator-(const BigInt& a, const BigInt& b);
+
+    BigInt randomBits(len_t bits, std::mt19937_64& rng); // uniform in [0, 2^bits)
+    BigInt randomBelow(const BigInt& bound, std::mt19937_64& rng); // uniform in [0, bound)
+    BigInt randomPrime(len_t bits, std::mt19937_64& rng, unsigned threads = 1); // a random prime of exactly `bits` bits
+    bool isProbablePrime(const BigInt& n, int rounds = 0); // trial division, then BPSW and `rounds` extra Miller-Rabin bases
+    BigInt nextPrime(const BigInt& n, unsigned threads = 1); // the smallest prime > n
 }
 #endif
@@ -7,6 +7,9 @@ int main()
 {
     //additionTest();
     //multiplicationTest();
+    //primalityTest();
+    //storageTest();
+    //ioTest();
 
 //    const BigInt N_TWO{ -2 };
 //    const BigInt N_THREE{ -3 };
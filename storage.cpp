@@ -0,0 +1,157 @@
+#include <cassert>
+#include <cstdlib>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define RUAN_BIGINTS_MMAP
+#include <sys/mman.h>
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+#include "storage.hpp"
+
+
+
+namespace BigInts
+{
+    namespace
+    {
+        struct Header // stored right before the digits
+        {
+            std::uint64_t mapped; // the size of the whole mapping in bytes, or 0 if on the heap
+            std::uint64_t padding; // keep the digits 16-byte aligned
+        };
+
+        len_t mappedThreshold = MAPPED_THRESHOLD_G;
+        std::string tempDirectory = "";
+
+        const Header* headerOf(const digit_t *digits)
+        {
+            return reinterpret_cast<const Header*>(digits) - 1;
+        }
+
+#ifdef RUAN_BIGINTS_MMAP
+        std::uint64_t pageSize()
+        {
+            static const std::uint64_t size = sysconf(_SC_PAGESIZE);
+            return size;
+        }
+
+        void* mapTempFile(std::uint64_t bytes)
+        {
+            std::string dir = tempDirectory;
+            if (dir.empty())
+            {
+                const char *env = std::getenv("TMPDIR");
+                dir = (env != nullptr && *env != '\0' ? env : "/tmp");
+            }
+            std::string name = dir + "/bigints-XXXXXX";
+            std::vector<char> path(name.begin(), name.end());
+            path.push_back('\0');
+
+            int fd = mkstemp(path.data());
+            if (fd < 0) throw std::bad_alloc{};
+            unlink(path.data()); // the file goes away as soon as it is unmapped
+
+            // reserve the blocks up front: writing to a hole in a sparse file on a full disk raises SIGBUS
+#ifdef __APPLE__
+            bool reserved = (ftruncate(fd, bytes) == 0); // no posix_fallocate; the file may be sparse
+#else
+            bool reserved = (posix_fallocate(fd, 0, bytes) == 0);
+#endif
+            void *p = MAP_FAILED;
+            if (reserved)
+                p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            close(fd); // the mapping keeps the file alive
+
+            if (p == MAP_FAILED) throw std::bad_alloc{};
+            madvise(p, bytes, MADV_SEQUENTIAL); // digits are mostly walked through in order
+            return p;
+        }
+
+        void advise(const digit_t *digits, len_t from, len_t to, int advice)
+        {
+            if (from >= to || !isMapped(digits)) return;
+
+            // madvise wants whole pages; rounding outwards is harmless, since the file keeps the data
+            const char *base = reinterpret_cast<const char*>(headerOf(digits));
+            std::uint64_t begin = reinterpret_cast<const char*>(digits + from) - base;
+            std::uint64_t end = reinterpret_cast<const char*>(digits + to) - base;
+            begin -= begin % pageSize();
+            end = std::min(headerOf(digits)->mapped, end + (pageSize() - end % pageSize()) % pageSize());
+            if (begin >= end) return; // past the end of the digits
+
+            madvise(const_cast<char*>(base) + begin, end - begin, advice);
+        }
+#endif
+    }
+
+    digit_t* allocDigits(len_t len) // room for len digits, nullptr if len == 0
+    {
+        assert (len >= 0 && "Can't allocate a negative amount of digits!");
+        if (len == 0) return nullptr;
+
+        std::uint64_t bytes = sizeof(Header) + (std::uint64_t)len*sizeof(digit_t);
+        Header *h;
+#ifdef RUAN_BIGINTS_MMAP
+        if (len >= mappedThreshold)
+        {
+            h = static_cast<Header*>(mapTempFile(bytes));
+            h->mapped = bytes;
+        }
+        else
+#endif
+        {
+            h = static_cast<Header*>(std::malloc(bytes));
+            if (h == nullptr) throw std::bad_alloc{};
+            h->mapped = 0;
+        }
+        return reinterpret_cast<digit_t*>(h + 1);
+    }
+    void freeDigits(digit_t *digits) // give back memory from allocDigits
+    {
+        if (digits == nullptr) return;
+
+        Header *h = reinterpret_cast<Header*>(digits) - 1;
+#ifdef RUAN_BIGINTS_MMAP
+        if (h->mapped != 0) { munmap(h, h->mapped); return; }
+#endif
+        std::free(h);
+    }
+    bool isMapped(const digit_t *digits) // are the digits backed by a temporary file?
+    {
+        return digits != nullptr && headerOf(digits)->mapped != 0;
+    }
+
+    void prefetchDigits(const digit_t *digits, len_t from, len_t to) // [from, to) is about to be used
+    {
+#ifdef RUAN_BIGINTS_MMAP
+        advise(digits, from, to, MADV_WILLNEED);
+#else
+        (void)digits; (void)from; (void)to;
+#endif
+    }
+    void releaseDigits(const digit_t *digits, len_t from, len_t to) // [from, to) isn't needed in memory for now
+    {
+#ifdef RUAN_BIGINTS_MMAP
+        advise(digits, from, to, MADV_DONTNEED); // a shared mapping reloads the pages from the file if needed
+#else
+        (void)digits; (void)from; (void)to;
+#endif
+    }
+
+    void setMappedThreshold(len_t digits) // map allocations of at least this many digits
+    {
+        assert (digits > 0 && "The mapped threshold must be positive!");
+        mappedThreshold = digits;
+    }
+    void setTempDirectory(const std::string& dir) // where the temporary files are made ($TMPDIR or /tmp by default)
+    {
+        tempDirectory = dir;
+    }
+}
@@ -0,0 +1,27 @@
+#include <string>
+
+#include "bigints.hpp"
+
+#ifndef RUAN_BIGINTS_STORAGE_HPP
+#define RUAN_BIGINTS_STORAGE_HPP
+
+namespace BigInts
+{
+    // Digits are kept on the heap, unless there are at least the mapped threshold of them.
+    // Then they live in an (already unlinked) temporary file that is memory mapped, so that
+    // numbers larger than physical memory can still be worked with.
+    constexpr len_t MAPPED_THRESHOLD_G = (len_t)1 << 27; // 512 MiB of digits
+    constexpr len_t STREAM_BLOCK_G = (len_t)1 << 20; // the amount of digits streamed over at a time
+
+    digit_t* allocDigits(len_t len); // room for len digits, nullptr if len == 0
+    void freeDigits(digit_t *digits); // give back memory from allocDigits
+    bool isMapped(const digit_t *digits); // are the digits backed by a temporary file?
+
+    // hints for mapped digits, a no-op otherwise
+    void prefetchDigits(const digit_t *digits, len_t from, len_t to); // [from, to) is about to be used
+    void releaseDigits(const digit_t *digits, len_t from, len_t to); // [from, to) isn't needed in memory for now
+
+    void setMappedThreshold(len_t digits); // map allocations of at least this many digits
+    void setTempDirectory(const std::string& dir); // where the temporary files are made ($TMPDIR or /tmp by default)
+}
+#endif